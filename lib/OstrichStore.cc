@@ -78,14 +78,15 @@ class CreateWorker : public Nan::AsyncWorker {
   string path;
   Controller* controller;
   bool read_only;
+  int8_t kc_opts;
 
 public:
-  CreateWorker(const char* path, bool read_only, Nan::Callback *callback)
-    : Nan::AsyncWorker(callback), path(path), read_only(read_only), controller(NULL) { };
+  CreateWorker(const char* path, bool read_only, int8_t kc_opts, Nan::Callback *callback)
+    : Nan::AsyncWorker(callback), path(path), read_only(read_only), kc_opts(kc_opts), controller(NULL) { };
 
   void Execute() {
     try {
-      controller = new Controller(path, HashDB::TCOMPRESS, read_only);
+      controller = new Controller(path, kc_opts, read_only);
     }
     catch (const std::invalid_argument error) { SetErrorMessage(error.what()); }
   }
@@ -103,12 +104,13 @@ public:
 };
 
 // Creates a new instance of OstrichStore.
-// JavaScript signature: createOstrichStore(path, readOnly, callback)
+// JavaScript signature: createOstrichStore(path, readOnly, storage, callback)
 NAN_METHOD(OstrichStore::Create) {
-  assert(info.Length() == 2);
+  assert(info.Length() == 4);
   Nan::AsyncQueueWorker(new CreateWorker(*Nan::Utf8String(info[0]),
                                          info[1]->BooleanValue(),
-                                         new Nan::Callback(info[2].As<Function>())));
+                                         info[2]->IsObject() ? toKyotoOptions(info[2].As<Object>()) : HashDB::TCOMPRESS,
+                                         new Nan::Callback(info[3].As<Function>())));
 }
 
 
@@ -124,16 +126,17 @@ class SearchTriplesVersionMaterializedWorker : public Nan::AsyncWorker {
   // Callback return values
   vector<Triple> triples;
   int version;
+  bool exactCount;
   uint32_t totalCount;
   bool hasExactCount;
   DictionaryManager* dict;
 
 public:
   SearchTriplesVersionMaterializedWorker(OstrichStore* store, char* subject, char* predicate, char* object,
-                      uint32_t offset, uint32_t limit, int32_t version, Nan::Callback* callback, Local<Object> self)
+                      uint32_t offset, uint32_t limit, int32_t version, bool exactCount, Nan::Callback* callback, Local<Object> self)
     : Nan::AsyncWorker(callback),
       store(store), subject(subject), predicate(predicate), object(object),
-      offset(offset), limit(limit), version(version), totalCount(0) {
+      offset(offset), limit(limit), version(version), exactCount(exactCount), totalCount(0) {
     SaveToPersistent("self", self);
   };
 
@@ -149,8 +152,8 @@ public:
       dict = controller->get_dictionary_manager(version);
       Triple triple_pattern(subject, predicate, toHdtLiteral(object), dict);
 
-      // Estimate the total number of triples
-      std::pair<size_t, ResultEstimationType> count_data = controller->get_version_materialized_count(triple_pattern, version, true);
+      // Estimate the total number of triples, or count them exactly if requested
+      std::pair<size_t, ResultEstimationType> count_data = controller->get_version_materialized_count(triple_pattern, version, !exactCount);
       totalCount = count_data.first;
       it = controller->get_version_materialized(triple_pattern, offset, version);
       hasExactCount = count_data.second == EXACT;
@@ -203,14 +206,14 @@ public:
 };
 
 // Searches for a triple pattern in the document.
-// JavaScript signature: OstrichStore#_searchTriplesVersionMaterialized(subject, predicate, object, offset, limit, version, callback)
+// JavaScript signature: OstrichStore#_searchTriplesVersionMaterialized(subject, predicate, object, offset, limit, version, exactCount, callback, self)
 NAN_METHOD(OstrichStore::SearchTriplesVersionMaterialized) {
-  assert(info.Length() == 8);
+  assert(info.Length() == 9);
   Nan::AsyncQueueWorker(new SearchTriplesVersionMaterializedWorker(Unwrap<OstrichStore>(info.This()),
     *Nan::Utf8String(info[0]), *Nan::Utf8String(info[1]), *Nan::Utf8String(info[2]),
-    info[3]->Uint32Value(), info[4]->Uint32Value(), info[5]->Uint32Value(),
-    new Nan::Callback(info[6].As<Function>()),
-    info[7]->IsObject() ? info[7].As<Object>() : info.This()));
+    info[3]->Uint32Value(), info[4]->Uint32Value(), info[5]->Uint32Value(), info[6]->BooleanValue(),
+    new Nan::Callback(info[7].As<Function>()),
+    info[8]->IsObject() ? info[8].As<Object>() : info.This()));
 }
 
 /******** OstrichStore#_searchTriplesDeltaMaterialized ********/
@@ -223,16 +226,17 @@ class SearchTriplesDeltaMaterializedWorker : public Nan::AsyncWorker {
   // Callback return values
   vector<TripleDelta*> triples;
   int version_start, version_end;
+  bool exactCount;
   uint32_t totalCount;
   bool hasExactCount;
   DictionaryManager* dict;
 
 public:
   SearchTriplesDeltaMaterializedWorker(OstrichStore* store, char* subject, char* predicate, char* object,
-                      uint32_t offset, uint32_t limit, int32_t version_start, int32_t version_end, Nan::Callback* callback, Local<Object> self)
+                      uint32_t offset, uint32_t limit, int32_t version_start, int32_t version_end, bool exactCount, Nan::Callback* callback, Local<Object> self)
     : Nan::AsyncWorker(callback),
       store(store), subject(subject), predicate(predicate), object(object),
-      offset(offset), limit(limit), version_start(version_start), version_end(version_end), totalCount(0) {
+      offset(offset), limit(limit), version_start(version_start), version_end(version_end), exactCount(exactCount), totalCount(0) {
     SaveToPersistent("self", self);
   };
 
@@ -248,8 +252,8 @@ public:
       dict = controller->get_dictionary_manager(version_start);
       Triple triple_pattern(subject, predicate, toHdtLiteral(object), dict);
 
-      // Estimate the total number of triples
-      std::pair<size_t, ResultEstimationType> count_data = controller->get_delta_materialized_count(triple_pattern, version_start, version_end, true);
+      // Estimate the total number of triples, or count them exactly if requested
+      std::pair<size_t, ResultEstimationType> count_data = controller->get_delta_materialized_count(triple_pattern, version_start, version_end, !exactCount);
       totalCount = count_data.first;
       it = controller->get_delta_materialized(triple_pattern, offset, version_start, version_end);
       hasExactCount = count_data.second == EXACT;
@@ -304,14 +308,14 @@ public:
 };
 
 // Searches for a triple pattern in the document.
-// JavaScript signature: OstrichStore#_searchTriplesDeltaMaterialized(subject, predicate, object, offset, limit, version, callback)
+// JavaScript signature: OstrichStore#_searchTriplesDeltaMaterialized(subject, predicate, object, offset, limit, version_start, version_end, exactCount, callback, self)
 NAN_METHOD(OstrichStore::SearchTriplesDeltaMaterialized) {
-  assert(info.Length() == 8);
+  assert(info.Length() == 10);
   Nan::AsyncQueueWorker(new SearchTriplesDeltaMaterializedWorker(Unwrap<OstrichStore>(info.This()),
     *Nan::Utf8String(info[0]), *Nan::Utf8String(info[1]), *Nan::Utf8String(info[2]),
-    info[3]->Uint32Value(), info[4]->Uint32Value(), info[5]->Uint32Value(), info[6]->Uint32Value(),
-    new Nan::Callback(info[7].As<Function>()),
-    info[8]->IsObject() ? info[8].As<Object>() : info.This()));
+    info[3]->Uint32Value(), info[4]->Uint32Value(), info[5]->Uint32Value(), info[6]->Uint32Value(), info[7]->BooleanValue(),
+    new Nan::Callback(info[8].As<Function>()),
+    info[9]->IsObject() ? info[9].As<Object>() : info.This()));
 }
 
 /******** OstrichStore#_searchTriplesVersion ********/
@@ -321,19 +325,21 @@ class SearchTriplesVersionWorker : public Nan::AsyncWorker {
   // JavaScript function arguments
   string subject, predicate, object;
   uint32_t offset, limit;
+  bool versionRanges, exactCount;
   Persistent<Object> self;
   // Callback return values
-  vector<TripleVersions*> triples;
+  vector<Triple*> triples;
+  vector<vector<int>*> versions;
   uint32_t totalCount;
   bool hasExactCount;
   DictionaryManager* dict;
 
 public:
   SearchTriplesVersionWorker(OstrichStore* store, char* subject, char* predicate, char* object,
-                      uint32_t offset, uint32_t limit, Nan::Callback* callback, Local<Object> self)
+                      uint32_t offset, uint32_t limit, bool versionRanges, bool exactCount, Nan::Callback* callback, Local<Object> self)
     : Nan::AsyncWorker(callback),
       store(store), subject(subject), predicate(predicate), object(object),
-      offset(offset), limit(limit), totalCount(0) {
+      offset(offset), limit(limit), versionRanges(versionRanges), exactCount(exactCount), totalCount(0) {
     SaveToPersistent("self", self);
   };
 
@@ -346,8 +352,8 @@ public:
       dict = controller->get_dictionary_manager(0);
       Triple triple_pattern(subject, predicate, toHdtLiteral(object), dict);
 
-      // Estimate the total number of triples
-      std::pair<size_t, ResultEstimationType> count_data = controller->get_version_count(triple_pattern, true);
+      // Estimate the total number of triples, or count them exactly if requested
+      std::pair<size_t, ResultEstimationType> count_data = controller->get_version_count(triple_pattern, !exactCount);
       totalCount = count_data.first;
       it = controller->get_version(triple_pattern, offset);
       hasExactCount = count_data.second == EXACT;
@@ -357,7 +363,8 @@ public:
       long count = 0;
 
       while(it->next(&t) && (!limit || triples.size() < limit)) {
-          triples.push_back(new TripleVersions(new Triple(*t.get_triple()), new std::vector<int>(*t.get_versions())));
+          triples.push_back(new Triple(*t.get_triple()));
+          versions.push_back(toVersionRanges(*t.get_versions()));
           count++;
       };
     }
@@ -376,22 +383,34 @@ public:
     const Local<String> PREDICATE = Nan::New("predicate").ToLocalChecked();
     const Local<String> OBJECT    = Nan::New("object").ToLocalChecked();
     const Local<String> VERSIONS  = Nan::New("versions").ToLocalChecked();
-    for (vector<TripleVersions*>::iterator it = triples.begin(); it != triples.end(); it++) {
+    for (uint32_t i = 0; i < triples.size(); i++) {
       Local<Object> tripleObject = Nan::New<Object>();
-      tripleObject->Set(SUBJECT, Nan::New((*it)->get_triple()->get_subject(*dict).c_str()).ToLocalChecked());
-      tripleObject->Set(PREDICATE, Nan::New((*it)->get_triple()->get_predicate(*dict).c_str()).ToLocalChecked());
-      string object = (*it)->get_triple()->get_object(*dict);
+      tripleObject->Set(SUBJECT, Nan::New(triples[i]->get_subject(*dict).c_str()).ToLocalChecked());
+      tripleObject->Set(PREDICATE, Nan::New(triples[i]->get_predicate(*dict).c_str()).ToLocalChecked());
+      string object = triples[i]->get_object(*dict);
       tripleObject->Set(OBJECT, Nan::New(fromHdtLiteral(object).c_str()).ToLocalChecked());
 
-      Local<Array> versionsArray = Nan::New<Array>((*it)->get_versions()->size());
-      for (uint32_t countVersions = 0; countVersions < (*it)->get_versions()->size(); countVersions++) {
-        versionsArray->Set(countVersions, Nan::New((*((*it)->get_versions()))[countVersions]));
+      // The versions are stored as flattened inclusive [start, end] ranges,
+      // which are either emitted as-is or expanded into the individual versions.
+      const vector<int>& ranges = *versions[i];
+      Local<Array> versionsArray = Nan::New<Array>();
+      uint32_t countVersions = 0;
+      for (uint32_t countRanges = 0; countRanges < ranges.size(); countRanges += 2) {
+        if (versionRanges) {
+          Local<Array> rangeArray = Nan::New<Array>(2);
+          rangeArray->Set(0, Nan::New(ranges[countRanges]));
+          rangeArray->Set(1, Nan::New(ranges[countRanges + 1]));
+          versionsArray->Set(countVersions++, rangeArray);
+        } else {
+          for (int version = ranges[countRanges]; version <= ranges[countRanges + 1]; version++)
+            versionsArray->Set(countVersions++, Nan::New(version));
+        }
       }
       tripleObject->Set(VERSIONS, versionsArray);
 
       triplesArray->Set(count++, tripleObject);
-      delete (*it)->get_triple();
-      delete (*it)->get_versions();
+      delete triples[i];
+      delete versions[i];
     }
 
     // Send the JavaScript array and estimated total count through the callback
@@ -410,14 +429,14 @@ public:
 };
 
 // Searches for a triple pattern in the document.
-// JavaScript signature: OstrichStore#_searchTriplesVersion(subject, predicate, object, offset, limit, callback)
+// JavaScript signature: OstrichStore#_searchTriplesVersion(subject, predicate, object, offset, limit, versionRanges, exactCount, callback, self)
 NAN_METHOD(OstrichStore::SearchTriplesVersion) {
-  assert(info.Length() == 8);
+  assert(info.Length() == 9);
   Nan::AsyncQueueWorker(new SearchTriplesVersionWorker(Unwrap<OstrichStore>(info.This()),
     *Nan::Utf8String(info[0]), *Nan::Utf8String(info[1]), *Nan::Utf8String(info[2]),
-    info[3]->Uint32Value(), info[4]->Uint32Value(),
-    new Nan::Callback(info[5].As<Function>()),
-    info[6]->IsObject() ? info[6].As<Object>() : info.This()));
+    info[3]->Uint32Value(), info[4]->Uint32Value(), info[5]->BooleanValue(), info[6]->BooleanValue(),
+    new Nan::Callback(info[7].As<Function>()),
+    info[8]->IsObject() ? info[8].As<Object>() : info.This()));
 }
 
 /******** OstrichStore#_append ********/
@@ -599,6 +618,29 @@ NAN_PROPERTY_GETTER(OstrichStore::Closed) {
 /******** Utility functions ********/
 
 
+// Converts a JavaScript storage profile into Kyoto Cabinet tuning options for the patch trees.
+// The profile is an object with the optional fields
+//   compression: 'zlib' (default) or 'none'
+//   small:       use 32-bit record addressing, for trees below 16GB
+//   linear:      use linear collision chaining instead of binary trees
+// These options only apply when a patch tree is created;
+// existing patch trees keep the options they were created with.
+int8_t toKyotoOptions(const Local<Object>& storage) {
+  int8_t kc_opts = 0;
+  const Local<String> COMPRESSION = Nan::New("compression").ToLocalChecked();
+  const Local<String> SMALL       = Nan::New("small").ToLocalChecked();
+  const Local<String> LINEAR      = Nan::New("linear").ToLocalChecked();
+  Local<Value> compression = storage->Get(COMPRESSION);
+  if (compression->IsUndefined() || string(*Nan::Utf8String(compression)) != "none")
+    kc_opts |= HashDB::TCOMPRESS;
+  if (storage->Get(SMALL)->BooleanValue())
+    kc_opts |= HashDB::TSMALL;
+  if (storage->Get(LINEAR)->BooleanValue())
+    kc_opts |= HashDB::TLINEAR;
+  return kc_opts;
+}
+
+
 // The JavaScript representation for a literal with a datatype is
 //   "literal"^^http://example.org/datatype
 // whereas the HDT representation is
@@ -645,3 +687,17 @@ string& fromHdtLiteral(string& literal) {
   }
   return literal;
 }
+
+// Compacts a list of versions into flattened inclusive ranges,
+// e.g., [0, 1, 2, 5, 6] becomes [0, 2, 5, 6].
+// Consecutive versions are merged, so the result size is proportional to the number of changes.
+vector<int>* toVersionRanges(const vector<int>& versions) {
+  vector<int>* ranges = new vector<int>();
+  for (vector<int>::const_iterator it = versions.begin(); it != versions.end(); it++) {
+    if (!ranges->empty() && ranges->back() + 1 == *it)
+      ranges->back() = *it;
+    else
+      ranges->push_back(*it), ranges->push_back(*it);
+  }
+  return ranges;
+}
@@ -15,7 +15,7 @@ class OstrichStore : public node::ObjectWrap {
  public:
   OstrichStore(string path, const v8::Local<v8::Object>& handle, Controller* controller);
 
-  // createOstrichStore(path, callback)
+  // createOstrichStore(path, readOnly, storage, callback)
   static NAN_METHOD(Create);
   static const Nan::Persistent<v8::Function>& GetConstructor();
 
@@ -33,11 +33,11 @@ class OstrichStore : public node::ObjectWrap {
   void Destroy(bool remove);
   static NAN_METHOD(New);
 
-  // OstrichStore#_searchTriplesVersionMaterialized(subject, predicate, object, offset, limit, version, callback, self)
+  // OstrichStore#_searchTriplesVersionMaterialized(subject, predicate, object, offset, limit, version, exactCount, callback, self)
   static NAN_METHOD(SearchTriplesVersionMaterialized);
-  // OstrichStore#_searchTriplesDeltaMaterialized(subject, predicate, object, offset, limit, version_start, version_end, callback, self)
+  // OstrichStore#_searchTriplesDeltaMaterialized(subject, predicate, object, offset, limit, version_start, version_end, exactCount, callback, self)
   static NAN_METHOD(SearchTriplesDeltaMaterialized);
-  // OstrichStore#_searchTriplesVersion(subject, predicate, object, offset, limit, callback, self)
+  // OstrichStore#_searchTriplesVersion(subject, predicate, object, offset, limit, versionRanges, exactCount, callback, self)
   static NAN_METHOD(SearchTriplesVersion);
   // OstrichStore#maxVersion
   static NAN_PROPERTY_GETTER(MaxVersion);
@@ -51,9 +51,13 @@ class OstrichStore : public node::ObjectWrap {
   static NAN_PROPERTY_GETTER(Closed);
 };
 
+// Converts a JavaScript storage profile into Kyoto Cabinet tuning options
+int8_t toKyotoOptions(const v8::Local<v8::Object>& storage);
 // Converts a JavaScript literal to an HDT literal
 std::string& toHdtLiteral(std::string& literal);
 // Converts an HDT literal to a JavaScript literal
 std::string& fromHdtLiteral(std::string& literal);
+// Compacts a list of versions into flattened inclusive [start, end] ranges
+std::vector<int>* toVersionRanges(const std::vector<int>& versions);
 
 #endif
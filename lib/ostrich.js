@@ -1,6 +1,9 @@
 var ostrichNative = require('../build/Release/ostrich');
 var fs = require('fs');
 
+// The maximum number of exact counts that are remembered per store
+var MAX_EXACT_COUNTS = 10000;
+
 // A string comparison function that is consistent with the sorting that happens in the string::compare function in C++
 function strcmp(a, b) {
   var i, n;
@@ -25,25 +28,25 @@ OstrichStorePrototype.searchTriplesVersionMaterialized = function (subject, pred
   var offset  = options && options.offset  ? Math.max(0, parseInt(options.offset, 10)) : 0,
       limit   = options && options.limit   ? Math.max(0, parseInt(options.limit,  10)) : 0,
       version = options && (options.version || options.version === 0) ? parseInt(options.version, 10) : -1;
+  if (version < 0) version = this.maxVersion;
 
   var this_ = this;
-  this._operations++;
-  this._searchTriplesVersionMaterialized(subject, predicate, object, offset, limit, version,
-    function (error, triples, totalCount, hasExactCount) {
-      this_._operations--;
-      callback.call(self || this_, error, triples, totalCount, hasExactCount);
-      this_._finishOperation();
-    }, self);
+  this._searchCounted(['vm', subject, predicate, object, version],
+    function (offset, limit, exactCount, done) {
+      this_._searchTriplesVersionMaterialized(subject, predicate, object, offset, limit, version, exactCount, done, self);
+    }, offset, limit, options && options.onExactCount, callback, self);
 };
 
 // Gives an approximate number of matches of triples with the given subject, predicate, object and version for a version materialized query.
-OstrichStorePrototype.countTriplesVersionMaterialized = function (subject, predicate, object, version, callback, self) {
+OstrichStorePrototype.countTriplesVersionMaterialized = function (subject, predicate, object, version, callback, onExactCount, self) {
   if (typeof version === 'function') {
-    self = callback;
+    self = onExactCount;
+    onExactCount = callback;
     callback = version;
     version = -1;
   }
-  this.searchTriplesVersionMaterialized(subject, predicate, object, { offset: 0, limit: 1, version: version },
+  if (typeof onExactCount !== 'function') self = onExactCount, onExactCount = null;
+  this.searchTriplesVersionMaterialized(subject, predicate, object, { offset: 0, limit: 1, version: version, onExactCount: onExactCount },
     function (error, triples, totalCount, hasExactCount) {
       callback.call(this, error, totalCount, hasExactCount);
     }, self);
@@ -68,18 +71,17 @@ OstrichStorePrototype.searchTriplesDeltaMaterialized = function (subject, predic
   if (versionEnd > this.maxVersion) return callback.call(self || this, new Error('`versionEnd` can not be larger than the maximum version.'));
 
   var this_ = this;
-  this._operations++;
-  this._searchTriplesDeltaMaterialized(subject, predicate, object, offset, limit, versionStart, versionEnd,
-    function (error, triples, totalCount, hasExactCount) {
-      this_._operations--;
-      callback.call(self || this_, error, triples, totalCount, hasExactCount);
-      this_._finishOperation();
-    }, self);
+  this._searchCounted(['dm', subject, predicate, object, versionStart, versionEnd],
+    function (offset, limit, exactCount, done) {
+      this_._searchTriplesDeltaMaterialized(subject, predicate, object, offset, limit, versionStart, versionEnd, exactCount, done, self);
+    }, offset, limit, options.onExactCount, callback, self);
 };
 
 // Gives an approximate number of matches of triples with the given subject, predicate, object, versionStart and versionEnd for a delta materialized query.
-OstrichStorePrototype.countTriplesDeltaMaterialized = function (subject, predicate, object, versionStart, versionEnd, callback, self) {
-  this.searchTriplesDeltaMaterialized(subject, predicate, object, { offset: 0, limit: 1, versionStart: versionStart, versionEnd: versionEnd },
+OstrichStorePrototype.countTriplesDeltaMaterialized = function (subject, predicate, object, versionStart, versionEnd, callback, onExactCount, self) {
+  if (typeof onExactCount !== 'function') self = onExactCount, onExactCount = null;
+  this.searchTriplesDeltaMaterialized(subject, predicate, object,
+    { offset: 0, limit: 1, versionStart: versionStart, versionEnd: versionEnd, onExactCount: onExactCount },
     function (error, triples, totalCount, hasExactCount) {
       callback.call(this, error, totalCount, hasExactCount);
     }, self);
@@ -95,21 +97,100 @@ OstrichStorePrototype.searchTriplesVersion = function (subject, predicate, objec
   if (typeof predicate !== 'string' || predicate[0] === '?') predicate = '';
   if (typeof    object !== 'string' ||    object[0] === '?') object    = '';
   var offset  = options && options.offset  ? Math.max(0, parseInt(options.offset, 10)) : 0,
-      limit   = options && options.limit   ? Math.max(0, parseInt(options.limit,  10)) : 0;
+      limit   = options && options.limit   ? Math.max(0, parseInt(options.limit,  10)) : 0,
+      versionRanges = !!(options && options.versionRanges);
 
   var this_ = this;
+  this._searchCounted(['v', subject, predicate, object],
+    function (offset, limit, exactCount, done) {
+      this_._searchTriplesVersion(subject, predicate, object, offset, limit, versionRanges, exactCount, done, self);
+    }, offset, limit, options && options.onExactCount, callback, self);
+};
+
+// Executes the given search, in which an estimated count is replaced by the exact count if that was determined before.
+// If an onExactCount callback is given for an estimated count, the exact count is determined in the background.
+OstrichStorePrototype._searchCounted = function (query, search, offset, limit, onExactCount, callback, self) {
+  var this_ = this, key = JSON.stringify(query);
   this._operations++;
-  this._searchTriplesVersion(subject, predicate, object, offset, limit,
-    function (error, triples, totalCount, hasExactCount) {
+  search(offset, limit, false, function (error, triples, totalCount, hasExactCount) {
+    this_._operations--;
+    var exactCount = error ? undefined : this_._getExactCount(key);
+    if (exactCount !== undefined)
+      totalCount = exactCount, hasExactCount = true;
+    callback.call(self || this_, error, triples, totalCount, hasExactCount);
+    if (typeof onExactCount === 'function') {
+      if (error || hasExactCount)
+        onExactCount.call(self || this_, error, totalCount);
+      else {
+        this_._refineCount(key, search, function (error, exactCount) {
+          onExactCount.call(self || this_, error, exactCount);
+        });
+      }
+    }
+    this_._finishOperation();
+  });
+};
+
+// Determines the exact count for the given search, and stores it for later searches.
+// Exact counts are determined one at a time, so they only use a single worker thread next to the other operations.
+// Queued counts are dropped once the store is being closed, or once a version has been appended after their estimate.
+OstrichStorePrototype._refineCount = function (key, search, callback) {
+  var this_ = this, generation = this._exactCountsGeneration;
+  this._exactCountsQueue.push(function () {
+    if (generation !== this_._exactCountsGeneration) return next(outdatedError());
+    var exactCount = this_._getExactCount(key);
+    if (exactCount !== undefined) return next(null, exactCount);
+    if (this_.closed || this_._isClosingCallbacks) return next(new Error('Ostrich cannot be read because it is closed'));
+    this_._operations++;
+    search(0, 1, true, function (error, triples, totalCount) {
       this_._operations--;
-      callback.call(self || this_, error, triples, totalCount, hasExactCount);
+      if (!error && generation !== this_._exactCountsGeneration)
+        error = outdatedError();
+      if (!error)
+        this_._setExactCount(key, totalCount);
       this_._finishOperation();
-    }, self);
+      next(error, totalCount);
+    });
+  });
+  if (this._exactCountsQueue.length === 1)
+    this._exactCountsQueue[0]();
+
+  function outdatedError() {
+    return new Error('The exact count is outdated because a version was appended');
+  }
+
+  function next(error, totalCount) {
+    callback(error, totalCount);
+    this_._exactCountsQueue.shift();
+    if (this_._exactCountsQueue.length)
+      this_._exactCountsQueue[0]();
+  }
+};
+
+// Gets the stored exact count for the given query key, or undefined if it is unknown.
+OstrichStorePrototype._getExactCount = function (key) {
+  if (!(key in this._exactCounts))
+    return undefined;
+  // Mark the count as recently used
+  this._exactCountsKeys.splice(this._exactCountsKeys.indexOf(key), 1);
+  this._exactCountsKeys.push(key);
+  return this._exactCounts[key];
+};
+
+// Stores the exact count for the given query key, removing the least recently used count if the maximum is reached.
+OstrichStorePrototype._setExactCount = function (key, exactCount) {
+  if (key in this._exactCounts)
+    this._exactCountsKeys.splice(this._exactCountsKeys.indexOf(key), 1);
+  else if (this._exactCountsKeys.length >= MAX_EXACT_COUNTS)
+    delete this._exactCounts[this._exactCountsKeys.shift()];
+  this._exactCountsKeys.push(key);
+  this._exactCounts[key] = exactCount;
 };
 
 // Gives an approximate number of matches of triples with the given subject, predicate and object for a version query.
-OstrichStorePrototype.countTriplesVersion = function (subject, predicate, object, callback, self) {
-  this.searchTriplesVersion(subject, predicate, object, { offset: 0, limit: 1 },
+OstrichStorePrototype.countTriplesVersion = function (subject, predicate, object, callback, onExactCount, self) {
+  if (typeof onExactCount !== 'function') self = onExactCount, onExactCount = null;
+  this.searchTriplesVersion(subject, predicate, object, { offset: 0, limit: 1, onExactCount: onExactCount },
     function (error, triples, totalCount, hasExactCount) {
       callback.call(this, error, totalCount, hasExactCount);
     }, self);
@@ -159,6 +240,10 @@ OstrichStorePrototype.appendSorted = function (version, triples, callback, self)
   this._operations++;
   this._append(version, triples, function (error, insertedCount) {
     this_._operations--;
+    // Exact counts may have changed with the new version
+    this_._exactCounts = {};
+    this_._exactCountsKeys = [];
+    this_._exactCountsGeneration++;
     callback.call(self || this, error, insertedCount);
     this_._finishOperation();
   }, self);
@@ -214,18 +299,25 @@ OstrichStorePrototype.close = function (remove, callback, self) {
 
 module.exports = {
   // Creates an Ostrich store for the given path.
-  fromPath: function (path, readOnly, callback, self) {
-    if (typeof readOnly !== 'boolean') self = callback, callback = readOnly, readOnly = true;
+  // The optional options object can contain a `storage` profile for the patch trees.
+  fromPath: function (path, readOnly, options, callback, self) {
+    if (typeof readOnly !== 'boolean') self = callback, callback = options, options = readOnly, readOnly = true;
+    if (typeof  options === 'function') self = callback, callback = options, options = {};
     if (typeof callback !== 'function') return;
     if (typeof path !== 'string' || path.length === 0)
       return callback.call(self, Error('Invalid path: ' + path));
     if (path.charAt(path.length - 1) !== '/') path += '/';
+    var storage = options && options.storage || {};
+    if (typeof storage !== 'object' || Array.isArray(storage))
+      return callback.call(self, Error('Invalid storage profile: ' + storage));
+    if (storage.compression && storage.compression !== 'zlib' && storage.compression !== 'none')
+      return callback.call(self, Error('Unsupported compression codec: ' + storage.compression));
 
     if (!readOnly && !fs.existsSync(path))
       fs.mkdirSync(path);
 
     // Construct the native OstrichStore
-    ostrichNative.createOstrichStore(path, readOnly, function (error, document) {
+    ostrichNative.createOstrichStore(path, readOnly, storage, function (error, document) {
       // Abort the creation if any error occurred
       if (error)
         return callback.call(self, error);
@@ -242,6 +334,10 @@ module.exports = {
       document.readOnly = readOnly;
       document._operations = 0;
       document._operationsCallbacks = [];
+      document._exactCounts = {};
+      document._exactCountsKeys = [];
+      document._exactCountsGeneration = 0;
+      document._exactCountsQueue = [];
       callback.call(self, null, document);
     });
   },
@@ -142,6 +142,97 @@ describe('append', function () {
         });
       });
 
+      describe('with 3 triples for version 0 and a refined count', function () {
+        var document; prepareDocument(function (d) { document = d; });
+        var triples0 = [
+          { subject: 'a', predicate: 'a', object: 'a', addition: true },
+          { subject: 'a', predicate: 'a', object: 'b', addition: true },
+          { subject: 'a', predicate: 'a', object: 'c', addition: true },
+        ];
+        var triples1 = [
+          { subject: 'a', predicate: 'a', object: 'd', addition: true },
+        ];
+
+        beforeEach(function (done) {
+          document.append(0, triples0, function (error) {
+            if (error) return done(error);
+            document.countTriplesVersion('a', 'a', null,
+              function (error) { if (error) done(error); },
+              function (error, exactCount) {
+                if (!error) exactCount.should.equal(3);
+                done(error);
+              });
+          });
+        });
+
+        it('should report the exact count', function (done) {
+          document.countTriplesVersion('a', 'a', null,
+            function (error, countFound, hasExactCount) {
+              countFound.should.equal(3);
+              hasExactCount.should.be.true;
+              done(error);
+            });
+        });
+
+        it('should refine the new count after appending version 1', function (done) {
+          document.append(1, triples1, function (error) {
+            if (error) return done(error);
+            document.countTriplesVersion('a', 'a', null,
+              function (error) { if (error) done(error); },
+              function (error, exactCount) {
+                if (error) return done(error);
+                exactCount.should.equal(4);
+                document.countTriplesVersion('a', 'a', null,
+                  function (error, countFound, hasExactCount) {
+                    countFound.should.equal(4);
+                    hasExactCount.should.be.true;
+                    done(error);
+                  });
+              });
+          });
+        });
+      });
+
+      describe('with a triple that is deleted in version 1 and added again in version 2', function () {
+        var document; prepareDocument(function (d) { document = d; });
+        var triples0 = [
+          { subject: 'a', predicate: 'a', object: 'a', addition: true },
+          { subject: 'a', predicate: 'a', object: 'b', addition: true },
+        ];
+        var triples1 = [
+          { subject: 'a', predicate: 'a', object: 'a', addition: false },
+        ];
+        var triples2 = [
+          { subject: 'a', predicate: 'a', object: 'a', addition: true },
+        ];
+
+        beforeEach(function (done) {
+          document.append(0, triples0, function (error) {
+            if (error) return done(error);
+            document.append(1, triples1, function (error) {
+              if (error) return done(error);
+              document.append(2, triples2, done);
+            });
+          });
+        });
+
+        it('should have versions 0 and 2 for that triple', function (done) {
+          document.searchTriplesVersion('a', 'a', 'a',
+            function (error, triplesFound) {
+              triplesFound.should.eql([{ subject: 'a', predicate: 'a', object: 'a', versions: [0, 2] }]);
+              done(error);
+            });
+        });
+
+        it('should have version ranges [0, 0] and [2, 2] for that triple', function (done) {
+          document.searchTriplesVersion('a', 'a', 'a', { versionRanges: true },
+            function (error, triplesFound) {
+              triplesFound.should.eql([{ subject: 'a', predicate: 'a', object: 'a', versions: [[0, 0], [2, 2]] }]);
+              done(error);
+            });
+        });
+      });
+
       describe('with 3 non-sorted triples for version 0 and 4 triples for version 1', function () {
         var document; prepareDocument(function (d) { document = d; });
         var count = 0;
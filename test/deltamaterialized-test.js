@@ -1541,6 +1541,113 @@ describe('delta materialization', function () {
           hasExactCount.should.equal(true);
         });
       });
+
+      describe('with pattern a ?p ?o between version 1 and 2 with exact count refinement', function () {
+        var totalCount, hasExactCount, exactCount, nativeExactCounts = [];
+        before(function (done) {
+          spyExactCount(document, '_searchTriplesDeltaMaterialized', 7, nativeExactCounts);
+          document.searchTriplesDeltaMaterialized('a', '?p', '?o', {
+            versionStart: 1,
+            versionEnd: 2,
+            onExactCount: function (error, c) { exactCount = c; done(error); },
+          }, function (error, t, c, e) {
+            totalCount = c; hasExactCount = e;
+            if (error) done(error);
+          });
+        });
+        after(function () {
+          delete document._searchTriplesDeltaMaterialized;
+        });
+
+        it('should estimate the total count as 9', function () {
+          totalCount.should.equal(9);
+        });
+
+        it('should not be an exact count', function () {
+          hasExactCount.should.equal(false);
+        });
+
+        it('should refine the exact count as 1', function () {
+          exactCount.should.equal(1);
+        });
+
+        it('should have counted exactly in a second native search', function () {
+          nativeExactCounts.should.eql([false, true]);
+        });
+
+        describe('when searched again', function () {
+          before(function (done) {
+            nativeExactCounts.length = 0;
+            document.searchTriplesDeltaMaterialized('a', '?p', '?o', { versionStart: 1, versionEnd: 2 },
+              function (error, t, c, e) { totalCount = c; hasExactCount = e; done(error); });
+          });
+
+          it('should return 1', function () {
+            totalCount.should.equal(1);
+          });
+
+          it('should be an exact count', function () {
+            hasExactCount.should.equal(true);
+          });
+
+          it('should not have counted exactly again', function () {
+            nativeExactCounts.should.eql([false]);
+          });
+        });
+
+        describe('when counted with exact count refinement', function () {
+          before(function (done) {
+            nativeExactCounts.length = 0;
+            document.countTriplesDeltaMaterialized('a', '?p', '?o', 1, 2,
+              function (error, c, e) { totalCount = c; hasExactCount = e; if (error) done(error); },
+              function (error, c) { exactCount = c; done(error); });
+          });
+
+          it('should return 1', function () {
+            totalCount.should.equal(1);
+          });
+
+          it('should be an exact count', function () {
+            hasExactCount.should.equal(true);
+          });
+
+          it('should pass the exact count as 1', function () {
+            exactCount.should.equal(1);
+          });
+
+          it('should not have counted exactly again', function () {
+            nativeExactCounts.should.eql([false]);
+          });
+        });
+      });
+
+      describe('with pattern a ?p ?o between version 1 and 2 with exact count refinement while closing', function () {
+        var closingDocument, exactCountError;
+        before(function (done) {
+          var pending = 2;
+          ostrich.fromPath('./test/test.ostrich', function (error, ostrichStore) {
+            if (error) return done(error);
+            closingDocument = ostrichStore;
+            closingDocument.searchTriplesDeltaMaterialized('a', '?p', '?o', {
+              versionStart: 1,
+              versionEnd: 2,
+              onExactCount: function (error) { exactCountError = error; finish(); },
+            }, function (error) {
+              if (error) return done(error);
+              closingDocument.close(finish);
+            });
+          });
+          function finish(error) {
+            if (error) done(error);
+            else if (--pending === 0) done();
+          }
+        });
+
+        it('should fail the exact count', function () {
+          exactCountError.should.be.an.Error;
+          exactCountError.message.should.equal('Ostrich cannot be read because it is closed');
+        });
+      });
     });
 
     describe('being closed', function () {
@@ -1563,3 +1670,12 @@ describe('delta materialization', function () {
     });
   });
 });
+
+// Records the exactCount argument of every call to the given native search method
+function spyExactCount(document, method, exactCountIndex, exactCounts) {
+  var search = document[method];
+  document[method] = function () {
+    exactCounts.push(arguments[exactCountIndex]);
+    return search.apply(this, arguments);
+  };
+}
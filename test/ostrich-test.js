@@ -1,6 +1,7 @@
 require('should');
 
 var ostrich = require('../lib/ostrich');
+var fs = require('fs');
 
 describe('ostrich', function () {
   describe('The ostrich module', function () {
@@ -34,6 +35,93 @@ describe('ostrich', function () {
       });
     });
 
+    describe('with a non-object storage profile', function () {
+      it('should throw an error', function (done) {
+        var self = {};
+        ostrich.fromPath('./test/test.ostrich', { storage: 'none' }, function (error) {
+          this.should.equal(self);
+          error.should.be.an.Error;
+          error.message.should.equal('Invalid storage profile: none');
+          done();
+        }, self);
+      });
+    });
+
+    describe('with an unsupported compression codec', function () {
+      it('should throw an error', function (done) {
+        var self = {};
+        ostrich.fromPath('./test/test.ostrich', { storage: { compression: 'lz4' } }, function (error) {
+          this.should.equal(self);
+          error.should.be.an.Error;
+          error.message.should.equal('Unsupported compression codec: lz4');
+          done();
+        }, self);
+      });
+    });
+
+    describe('with a storage profile for a new store', function () {
+      var path = './test/test-profile.ostrich';
+      var profile = { storage: { compression: 'none', small: true, linear: true } };
+      var triples0 = [
+        { subject: 'a', predicate: 'a', object: 'a', addition: true },
+        { subject: 'a', predicate: 'a', object: 'b', addition: true },
+      ];
+      var triples1 = [
+        { subject: 'a', predicate: 'a', object: 'a', addition: false },
+        { subject: 'a', predicate: 'a', object: 'c', addition: true },
+      ];
+      before(function (done) {
+        ostrich.fromPath(path, false, profile, function (error, ostrichStore) {
+          if (error) return done(error);
+          ostrichStore.append(0, triples0, function (error) {
+            if (error) return done(error);
+            ostrichStore.append(1, triples1, function (error) {
+              if (error) return done(error);
+              ostrichStore.close(done);
+            });
+          });
+        });
+      });
+      after(function (done) {
+        ostrich.fromPath(path, false, function (error, ostrichStore) {
+          if (error) return done(error);
+          ostrichStore.close(true, done);
+        });
+      });
+
+      it('should have created patch tree files', function () {
+        fs.readdirSync(path).filter(function (file) { return /^patchtree_.*\.kct_/.test(file); })
+          .should.not.be.empty;
+      });
+
+      it('should return the appended triples when reopened', function (done) {
+        ostrich.fromPath(path, profile, function (error, ostrichStore) {
+          if (error) return done(error);
+          ostrichStore.maxVersion.should.equal(1);
+          ostrichStore.searchTriplesVersionMaterialized(null, null, null, { version: 1 },
+            function (error, triples) {
+              triples.should.eql([
+                { subject: 'a', predicate: 'a', object: 'b' },
+                { subject: 'a', predicate: 'a', object: 'c' },
+              ]);
+              ostrichStore.close();
+              done(error);
+            });
+        });
+      });
+    });
+
+    describe('with a storage profile', function () {
+      it('should open the existing store', function (done) {
+        ostrich.fromPath('./test/test.ostrich', { storage: { compression: 'none', small: true, linear: true } },
+          function (error, ostrichStore) {
+            ostrichStore.maxVersion.should.equal(2);
+            ostrichStore.close();
+            done(error);
+          });
+      });
+    });
+
     describe('with a self value', function () {
       it('should invoke the callback with that value as `this`', function (done) {
         var self = {};
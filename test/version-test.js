@@ -272,6 +272,51 @@ describe('version', function () {
         });
       });
 
+      describe('with pattern a b null and version ranges', function () {
+        var triples, totalCount, hasExactCount;
+        before(function (done) {
+          document.searchTriplesVersion('a', 'b', null, { versionRanges: true },
+            function (error, t, c, e) { triples = t; totalCount = c; hasExactCount = e; done(error); });
+        });
+
+        it('should return an array with matches', function () {
+          triples.should.be.an.Array;
+          triples.should.have.lengthOf(6);
+          triples[0].should.eql({ subject:   'a',
+            predicate: 'b',
+            object:    'a',
+            versions: [[0, 0]] });
+          triples[1].should.eql({ subject:   'a',
+            predicate: 'b',
+            object:    'c',
+            versions: [[0, 2]] });
+          triples[2].should.eql({ subject:   'a',
+            predicate: 'b',
+            object:    'd',
+            versions: [[0, 2]] });
+          triples[3].should.eql({ subject:   'a',
+            predicate: 'b',
+            object:    'f',
+            versions: [[0, 2]] });
+          triples[4].should.eql({ subject:   'a',
+            predicate: 'b',
+            object:    'z',
+            versions: [[0, 0]] });
+          triples[5].should.eql({ subject:   'a',
+            predicate: 'b',
+            object:    'g',
+            versions: [[1, 2]] });
+        });
+
+        it('should estimate the total count as 6', function () {
+          totalCount.should.equal(6);
+        });
+
+        it('should be an exact count', function () {
+          hasExactCount.should.equal(true);
+        });
+      });
+
       describe('with pattern f null null', function () {
         var triples, totalCount, hasExactCount;
         before(function (done) {